@@ -0,0 +1,52 @@
+#!/bin/sh
+# Builds the benchmark kernel ("make bench"), boots it headless and prints
+# the BENCH lines it writes to port 0xE9.
+#
+#   ./bench.sh [qemu|bochs] [timeout in seconds]
+#
+# The emulator runs on a copy of the boot floppy, so the files in this
+# directory are not changed. Needs mtools (mcopy) to put the kernel on the
+# floppy.
+
+EMULATOR=${1:-qemu}
+TIMEOUT=${2:-600}
+
+set -e
+
+make bench >&2
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+cp dev_kernel_grub.img "$WORK/floppy.img"
+mcopy -o -i "$WORK/floppy.img" bench.bin ::/kernel.bin
+
+set +e
+
+case "$EMULATOR" in
+qemu)
+    timeout "$TIMEOUT" qemu-system-i386 -m 32 -display none -no-reboot \
+        -fda "$WORK/floppy.img" -boot a \
+        -debugcon file:"$WORK/e9.txt" \
+        -device isa-debug-exit,iobase=0xf4,iosize=0x04 >&2
+    ;;
+bochs)
+    # Same machine as bochsrc.bxrc, without a display, on the copy.
+    sed -e "s|dev_kernel_grub.img|$WORK/floppy.img|" \
+        -e "s|^log:.*|log: $WORK/bochsout.txt|" \
+        -e "s|^romimage: file=|romimage: file=$PWD/|" \
+        -e "s|^vgaromimage: file=|vgaromimage: file=$PWD/|" \
+        bochsrc.bxrc > "$WORK/bochsrc.bxrc"
+    echo "display_library: nogui" >> "$WORK/bochsrc.bxrc"
+    timeout "$TIMEOUT" bochs -q -f "$WORK/bochsrc.bxrc" > "$WORK/e9.txt"
+    ;;
+*)
+    echo "usage: $0 [qemu|bochs] [timeout in seconds]" >&2
+    exit 2
+    ;;
+esac
+
+grep '^BENCH ' "$WORK/e9.txt"
+
+# The last line is "BENCH done" unless the kernel crashed or timed out.
+grep -q '^BENCH done' "$WORK/e9.txt"
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+Latency histograms from a kernel trace dump (see trace.H).
+
+Usage: trace_hist.py [FILE]
+
+FILE is the port 0xE9 output of the kernel (bochs prints it on stdout, or
+QEMU with -debugcon), or standard input. Lines that are not part of the
+dump are skipped.
+
+A BEGIN record is paired with the next END record of the same event and
+key, innermost first, and the cycles between them go into the histogram
+of the event. For context switches, the histogram is of the time a thread
+ran before the next switch.
+"""
+
+import sys
+
+EVENTS = {
+    1: "switch",
+    2: "thread",
+    3: "page_fault",
+    4: "frame_alloc",
+    5: "frame_free",
+    6: "disk",
+    7: "irq",
+    8: "second",
+    9: "vm_allocate",
+    10: "vm_release",
+}
+
+POINT, BEGIN, END = 0, 1, 2
+
+
+def read_records(lines):
+    records = []
+    for line in lines:
+        fields = line.split()
+        if len(fields) != 5 or fields[0] != "T":
+            continue
+        tsc = int(fields[1], 16)
+        event = int(fields[2][:2], 16)
+        phase = int(fields[2][2:], 16)
+        key = int(fields[3], 16)
+        arg = int(fields[4], 16)
+        records.append((tsc, event, phase, key, arg))
+    # Records are in the order their slots were claimed. An interrupt between
+    # claiming a slot and reading the clock can swap two neighbours.
+    records.sort(key=lambda r: r[0])
+    return records
+
+
+def latencies(records):
+    open_events = {}
+    samples = {}
+    unmatched = 0
+    last_switch = None
+
+    for tsc, event, phase, key, arg in records:
+        name = EVENTS.get(event, "event_%d" % event)
+        if event == 1:
+            if last_switch is not None:
+                samples.setdefault("run_slice", []).append(tsc - last_switch)
+            last_switch = tsc
+        elif phase == BEGIN:
+            open_events.setdefault((event, key), []).append(tsc)
+        elif phase == END:
+            stack = open_events.get((event, key))
+            if stack:
+                samples.setdefault(name, []).append(tsc - stack.pop())
+            else:
+                unmatched += 1
+    return samples, unmatched
+
+
+def print_histogram(name, values):
+    values = sorted(values)
+    n = len(values)
+    print("%s: n = %d min = %d p50 = %d p99 = %d max = %d avg = %d" % (
+        name, n, values[0], values[n // 2], values[min(n - 1, n * 99 // 100)],
+        values[-1], sum(values) // n))
+
+    # Power-of-two buckets of cycles.
+    buckets = {}
+    for v in values:
+        buckets[v.bit_length()] = buckets.get(v.bit_length(), 0) + 1
+    widest = max(buckets.values())
+    for bits in range(min(buckets), max(buckets) + 1):
+        count = buckets.get(bits, 0)
+        low = (1 << (bits - 1)) if bits > 0 else 0
+        bar = "#" * ((count * 50 + widest - 1) // widest)
+        print("  %10d .. %-10d %8d %s" % (low, (1 << bits) - 1, count, bar))
+    print()
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], errors="replace") as f:
+            records = read_records(f)
+    else:
+        records = read_records(sys.stdin)
+
+    if not records:
+        print("no trace records found")
+        return 1
+
+    samples, unmatched = latencies(records)
+    print("%d records, %d cycles" % (len(records), records[-1][0] - records[0][0]))
+    if unmatched:
+        print("%d END records without a BEGIN (overwritten in the ring)" % unmatched)
+    print()
+    for name in sorted(samples):
+        print_histogram(name, samples[name])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,67 @@
+#!/bin/sh
+# Builds the benchmark kernel ("make bench"), boots it headless and prints
+# the BENCH lines it writes to port 0xE9.
+#
+#   ./bench.sh [qemu|bochs] [timeout in seconds]
+#
+# The emulator runs on copies of the boot floppy and of the disk images, so
+# the files in this directory are not changed. Disk images that do not exist
+# are created empty. Needs mtools (mcopy) to put the kernel on the floppy.
+
+EMULATOR=${1:-qemu}
+TIMEOUT=${2:-600}
+
+# Geometry from bochsrc.bxrc: 306 cylinders, 4 heads, 17 sectors
+DISK_BYTES=$((306 * 4 * 17 * 512))
+
+set -e
+
+make bench >&2
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+cp dev_kernel_grub.img "$WORK/floppy.img"
+mcopy -o -i "$WORK/floppy.img" bench.bin ::/kernel.bin
+
+for disk in c.img d.img; do
+    if [ -f "$disk" ]; then
+        cp "$disk" "$WORK/$disk"
+    else
+        truncate -s $DISK_BYTES "$WORK/$disk"
+    fi
+done
+
+set +e
+
+case "$EMULATOR" in
+qemu)
+    timeout "$TIMEOUT" qemu-system-i386 -m 32 -display none -no-reboot \
+        -fda "$WORK/floppy.img" -boot a \
+        -drive file="$WORK/c.img",format=raw,if=ide,index=0 \
+        -drive file="$WORK/d.img",format=raw,if=ide,index=1 \
+        -debugcon file:"$WORK/e9.txt" \
+        -device isa-debug-exit,iobase=0xf4,iosize=0x04 >&2
+    ;;
+bochs)
+    # Same machine as bochsrc.bxrc, without a display, on the copies.
+    sed -e "s|dev_kernel_grub.img|$WORK/floppy.img|" \
+        -e "s|\"c.img\"|\"$WORK/c.img\"|" \
+        -e "s|\"d.img\"|\"$WORK/d.img\"|" \
+        -e "s|^log:.*|log: $WORK/bochsout.txt|" \
+        -e "s|^romimage: file=|romimage: file=$PWD/|" \
+        -e "s|^vgaromimage: file=|vgaromimage: file=$PWD/|" \
+        bochsrc.bxrc > "$WORK/bochsrc.bxrc"
+    echo "display_library: nogui" >> "$WORK/bochsrc.bxrc"
+    timeout "$TIMEOUT" bochs -q -f "$WORK/bochsrc.bxrc" > "$WORK/e9.txt"
+    ;;
+*)
+    echo "usage: $0 [qemu|bochs] [timeout in seconds]" >&2
+    exit 2
+    ;;
+esac
+
+grep '^BENCH ' "$WORK/e9.txt"
+
+# The last line is "BENCH done" unless the kernel crashed or timed out.
+grep -q '^BENCH done' "$WORK/e9.txt"